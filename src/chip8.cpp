@@ -1,5 +1,3 @@
-#include <SDL2/SDL_events.h>
-
 #include <array>
 #include <iostream>
 #include <fstream>
@@ -7,18 +5,16 @@
 #include "chip8.h"
 
 chip8::chip8() = default;
-chip8::~chip8() {
-	SDL_DestroyTexture(texture_);
-}
+chip8::~chip8() = default;
 
-void chip8::init(SDL_Renderer* renderer) {
+void chip8::reset() {
 	pc_ = 0x200; // program counter starts at 0x200
 	opcode_ = 0; // reset current opcode
 	i_ = 0;		 // reset index register
 	sp_ = 0;	 // reset stack pointer
 
 	// clear display
-	std::fill(std::begin(gfx_), std::end(gfx_), 0);
+	clear_display();
 
 	// clear stack, v, and key registers
 	std::fill(std::begin(stack_), std::end(stack_), 0);
@@ -27,12 +23,11 @@ void chip8::init(SDL_Renderer* renderer) {
 
 	// clear memory
 	std::fill(std::begin(memory_), std::end(memory_), 0);
+	memory_hash_ = 0;
 
 	// load fontset into memory
-	std::copy(std::begin(fontset_), std::end(fontset_), std::begin(memory_));
-
-	texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
-		SDL_TEXTUREACCESS_STREAMING, screen_width, screen_height);
+	for (size_t i = 0; i < fontset_.size(); ++i)
+		write_memory(static_cast<uint16_t>(i), fontset_[i]);
 
 	// reset timers and flags
 	delay_timer_ = 0;
@@ -41,64 +36,18 @@ void chip8::init(SDL_Renderer* renderer) {
 }
 
 void chip8::cycle() {
-	// fetch opcode
-	opcode_ = memory_[pc_] << 8 | memory_[pc_ + 1];
+	// fetch opcode, addresses wrap at 4k
+	opcode_ = memory_[pc_ & 0xFFF] << 8 | memory_[(pc_ + 1) & 0xFFF];
 
 	// decode opcode and execute
 	opcode_handler_.execute(*this, opcode_);
 }
 
-void chip8::draw(SDL_Renderer* renderer) {
-	if (should_draw_) {
-		std::array<uint32_t, static_cast<size_t>(screen_width) * screen_height> buffer;
-
-		// copy the gfx buffer to the back buffer
-		for (int i = 0; i < screen_width * screen_height; ++i)
-			buffer[i] = gfx_[i] ? 0xFFFFFFFF : 0xFF000000;
-
-		// update the texture with new pixel data, clear the renderer, and render the texture
-		SDL_UpdateTexture(texture_, nullptr, buffer.data(), screen_width * sizeof(uint32_t));
-		SDL_RenderClear(renderer);
-		SDL_RenderCopy(renderer, texture_, nullptr, nullptr);
-		SDL_RenderPresent(renderer);
-
-		// reset the draw flag
-		should_draw_ = false;
-	}
-}
-
-void chip8::input() {
-	SDL_Event e;
+void chip8::step_frame() {
+	for (int i = 0; i < cycles_per_frame; ++i)
+		cycle();
 
-	// map the chip-8 keypad to keyboard keys
-	static constexpr std::array<SDL_Keycode, 16> keymap = {
-		SDLK_x, SDLK_1, SDLK_2, SDLK_3,
-		SDLK_q, SDLK_w, SDLK_e, SDLK_a,
-		SDLK_s, SDLK_d, SDLK_z, SDLK_c,
-		SDLK_4, SDLK_r, SDLK_f, SDLK_v
-	};
-
-	while (SDL_PollEvent(&e)) {
-		if (e.type == SDL_QUIT)
-			quit_ = true;
-
-		if (e.type == SDL_KEYDOWN) {
-			if (e.key.keysym.sym == SDLK_ESCAPE)
-				quit_ = true;
-
-			// set key state to pressed 
-			for (int i = 0; i < 16; ++i)
-				if (e.key.keysym.sym == keymap[i])
-					key_[i] = 1;
-		}
-
-		if (e.type == SDL_KEYUP) {
-			// set key state to released
-			for (int i = 0; i < 16; ++i)
-				if (e.key.keysym.sym == keymap[i])
-					key_[i] = 0;
-		}
-	}
+	update_timers(); // timers tick once per 60hz frame
 }
 
 void chip8::update_timers() {
@@ -131,10 +80,67 @@ bool chip8::load_rom(const char* filename) {
 	file.read(buffer, size);
 	file.close();
 
-	// load the rom into memory starting at 0x200
-	for (int i = 0; i < size; ++i)
-		memory_[0x200 + i] = buffer[i];
+	const bool loaded = load_rom(reinterpret_cast<const uint8_t*>(buffer), static_cast<size_t>(size));
 
 	delete[] buffer;
+	return loaded;
+}
+
+bool chip8::load_rom(const uint8_t* data, const size_t size) {
+	if (size > (4096 - 512)) {
+		std::cerr << "rom buffer too large: " << size << " bytes" << std::endl;
+		return false;
+	}
+
+	// load the rom into memory starting at 0x200
+	for (size_t i = 0; i < size; ++i)
+		write_memory(static_cast<uint16_t>(0x200 + i), data[i]);
+
 	return true;
 }
+
+void chip8::clear_display() {
+	std::fill(std::begin(gfx_), std::end(gfx_), 0);
+	gfx_hash_ = 0;
+}
+
+uint64_t chip8::state_hash() const {
+	return memory_hash_ ^ gfx_hash_ ^ register_hash();
+}
+
+uint64_t chip8::recompute_state_hash() const {
+	uint64_t hash = register_hash();
+
+	for (size_t address = 0; address < sizeof(memory_); ++address)
+		hash ^= hash_key(address, memory_[address]);
+
+	for (size_t index = 0; index < sizeof(gfx_); ++index)
+		hash ^= hash_key(gfx_hash_base + index, gfx_[index]);
+
+	return hash;
+}
+
+uint64_t chip8::register_hash() const {
+	uint64_t hash = 0;
+	size_t location = register_hash_base;
+
+	// fold in a 16-bit value as two byte locations
+	const auto fold_word = [&](const uint16_t value) {
+		hash ^= hash_key(location++, value & 0xFF);
+		hash ^= hash_key(location++, value >> 8);
+	};
+
+	for (const uint8_t v : v_)
+		hash ^= hash_key(location++, v);
+
+	for (const uint16_t entry : stack_)
+		fold_word(entry);
+
+	fold_word(i_);
+	fold_word(pc_);
+	fold_word(sp_);
+
+	hash ^= hash_key(location++, delay_timer_);
+	hash ^= hash_key(location++, sound_timer_);
+	return hash;
+}
@@ -1,6 +1,6 @@
 #pragma once
-#include <SDL2/SDL_render.h>
 #include <array>
+#include <random>
 
 #include "opcode.h"
 
@@ -8,20 +8,38 @@ class chip8 {
 public:
 	static constexpr int screen_width = 64;
 	static constexpr int screen_height = 32;
-	static constexpr int window_scale = 10;
+	static constexpr int cycles_per_frame = 10;
 
 	chip8();
 	~chip8();
 
-	void init(SDL_Renderer* renderer);
-	void cycle();					   // emulate a single cycle
-	void draw(SDL_Renderer* renderer); // draw the graphics buffer to the screen
-	void input();					   // handle input events
-	void update_timers();			   // update the delay and sound timers
+	void reset();		  // reset the machine state
+	void cycle();		  // emulate a single cycle
+	void step_frame();	  // emulate one 60hz frame worth of cycles and tick the timers
+	void update_timers(); // update the delay and sound timers
+	void seed(uint32_t seed) { generator_.seed(seed); } // make Cxnn reproducible
 
 	bool load_rom(const char* filename);
+	bool load_rom(const uint8_t* data, size_t size);
 
-	bool should_quit() const { return quit_; }
+	// memory and display writes go through these so the state hash stays current,
+	// addresses wrap at 4k so a rom can never write outside memory_
+	void write_memory(uint16_t address, const uint8_t value) {
+		address &= 0xFFF;
+		memory_hash_ ^= hash_key(address, memory_[address]) ^ hash_key(address, value);
+		memory_[address] = value;
+	}
+
+	void toggle_pixel(const size_t index) {
+		gfx_hash_ ^= hash_key(gfx_hash_base + index, 1);
+		gfx_[index] ^= 1;
+	}
+
+	void clear_display();
+
+	// zobrist-style hash of memory, display, registers, stack, and timers (keypad excluded)
+	uint64_t state_hash() const;
+	uint64_t recompute_state_hash() const; // same hash rebuilt from scratch, for checking the incremental one
 
 	uint8_t memory_[4096];  // 4k memory
 	uint8_t v_[16];			// 16 general purpose registers
@@ -40,6 +58,8 @@ public:
 	uint8_t sound_timer_;	// sound timer
 
 	bool should_draw_;		// flag to indicate if the screen should be redrawn
+
+	std::mt19937 generator_{ std::random_device{}() }; // random number generator used by Cxnn
 private:
 	// chip8 fontset
 	static constexpr std::array<uint8_t, 80> fontset_ = {
@@ -64,7 +84,26 @@ private:
 	opcode opcode_handler_;
 	uint16_t opcode_; // current opcode
 
-	SDL_Texture* texture_; 
 
-	bool quit_;	 // flag to indicate if the program should quit
+	// memory and display hashes are maintained incrementally on every write,
+	// the small register file is folded in when the hash is queried
+	static constexpr size_t gfx_hash_base = 4096;
+	static constexpr size_t register_hash_base = gfx_hash_base + screen_width * screen_height;
+
+	uint64_t memory_hash_ = 0;
+	uint64_t gfx_hash_ = 0;
+
+	uint64_t register_hash() const;
+
+	// per (location, value) key, zero bytes contribute nothing so a cleared region hashes to 0
+	static uint64_t hash_key(const size_t location, const uint8_t value) {
+		if (value == 0)
+			return 0;
+
+		// splitmix64 finalizer
+		uint64_t z = (static_cast<uint64_t>(location) << 8 | value) + 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
 };
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <iterator>
+#include <new>
+
+#include "chip8_api.h"
+#include "chip8.h"
+#include "visited_set.h"
+
+struct chip8_instance {
+	chip8 c8;
+	uint64_t frame = 0;
+};
+
+struct chip8_visited {
+	explicit chip8_visited(const size_t capacity_log2) : set(capacity_log2) {}
+
+	visited_set set;
+};
+
+static_assert(CHIP8_FRAMEBUFFER_SIZE == chip8::screen_width * chip8::screen_height,
+	"c abi framebuffer size must match the emulator display");
+
+chip8_instance* chip8_create() {
+	// allocation failures must not unwind across the c abi, the opcode tables allocate too
+	chip8_instance* instance = nullptr;
+	try {
+		instance = new (std::nothrow) chip8_instance;
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+
+	if (instance)
+		instance->c8.reset();
+	return instance;
+}
+
+void chip8_destroy(chip8_instance* instance) {
+	delete instance;
+}
+
+void chip8_reset(chip8_instance* instance) {
+	instance->c8.reset();
+	instance->frame = 0;
+}
+
+void chip8_seed(chip8_instance* instance, const uint32_t seed) {
+	instance->c8.seed(seed);
+}
+
+bool chip8_load_rom(chip8_instance* instance, const uint8_t* data, const size_t size) {
+	return instance->c8.load_rom(data, size);
+}
+
+const uint8_t* chip8_memory(const chip8_instance* instance) {
+	return instance->c8.memory_;
+}
+
+uint64_t chip8_state_hash(const chip8_instance* instance) {
+	return instance->c8.state_hash();
+}
+
+static void fill_state(const chip8_instance& instance, const bool drawn, chip8_state& state) {
+	const chip8& c8 = instance.c8;
+
+	std::copy(std::begin(c8.v_), std::end(c8.v_), std::begin(state.v));
+	state.i = c8.i_;
+	state.pc = c8.pc_;
+	state.sp = c8.sp_;
+	state.delay_timer = c8.delay_timer_;
+	state.sound_timer = c8.sound_timer_;
+	state.drawn = drawn ? 1 : 0;
+	state.frame = instance.frame;
+	state.hash = c8.state_hash();
+}
+
+void chip8_step(chip8_instance* const* instances, const size_t count, const size_t n_frames,
+	const uint16_t* inputs, uint8_t* framebuffers, chip8_state* states) {
+	for (size_t n = 0; n < count; ++n) {
+		chip8_instance& instance = *instances[n];
+		chip8& c8 = instance.c8;
+		bool drawn = false;
+
+		for (size_t f = 0; f < n_frames; ++f) {
+			// latch the keypad for this frame
+			const uint16_t keys = inputs ? inputs[n * n_frames + f] : 0;
+			for (int k = 0; k < 16; ++k)
+				c8.key_[k] = (keys >> k) & 1;
+
+			c8.step_frame();
+
+			// no renderer consumes the draw flag here, so fold it into the step result
+			drawn |= c8.should_draw_;
+			c8.should_draw_ = false;
+			++instance.frame;
+		}
+
+		if (framebuffers)
+			std::copy(std::begin(c8.gfx_), std::end(c8.gfx_), framebuffers + n * CHIP8_FRAMEBUFFER_SIZE);
+
+		if (states)
+			fill_state(instance, drawn, states[n]);
+	}
+}
+
+chip8_visited* chip8_visited_create(const size_t capacity_log2) {
+	if (capacity_log2 == 0 || capacity_log2 > visited_set::max_capacity_log2)
+		return nullptr;
+
+	const auto visited = new (std::nothrow) chip8_visited(capacity_log2);
+	if (visited && !visited->set.valid()) {
+		delete visited;
+		return nullptr;
+	}
+
+	return visited;
+}
+
+void chip8_visited_destroy(chip8_visited* visited) {
+	delete visited;
+}
+
+bool chip8_visited_insert(chip8_visited* visited, const uint64_t hash) {
+	return visited->set.insert(hash);
+}
+
+size_t chip8_visited_size(const chip8_visited* visited) {
+	return visited->set.size();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// stable c abi for driving the emulator from other languages (built as chip8lib)
+
+#if defined(_WIN32)
+	#if defined(CHIP8_API_EXPORTS)
+		#define CHIP8_API __declspec(dllexport)
+	#else
+		#define CHIP8_API __declspec(dllimport)
+	#endif
+#else
+	#define CHIP8_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHIP8_SCREEN_WIDTH 64
+#define CHIP8_SCREEN_HEIGHT 32
+#define CHIP8_FRAMEBUFFER_SIZE (CHIP8_SCREEN_WIDTH * CHIP8_SCREEN_HEIGHT)
+
+typedef struct chip8_instance chip8_instance; // opaque handle
+typedef struct chip8_visited chip8_visited;	  // opaque handle to a lock-free set of state hashes
+
+// machine state reported after each step, rewards are derived from this by the caller
+typedef struct chip8_state {
+	uint8_t v[16];			// general purpose registers
+	uint16_t i;				// index register
+	uint16_t pc;			// program counter
+	uint16_t sp;			// stack pointer
+	uint8_t delay_timer;	// delay timer
+	uint8_t sound_timer;	// sound timer
+	uint8_t drawn;			// nonzero if the display changed during the step
+	uint64_t frame;			// total frames emulated since the last reset
+	uint64_t hash;			// machine state hash, see chip8_state_hash
+} chip8_state;
+
+// returns null if the instance could not be allocated
+CHIP8_API chip8_instance* chip8_create(void);
+CHIP8_API void chip8_destroy(chip8_instance* instance);
+
+// reset the machine, clearing memory and the loaded rom
+CHIP8_API void chip8_reset(chip8_instance* instance);
+
+// seed the generator behind Cxnn so rollouts can be reproduced, instances are randomly seeded on creation
+CHIP8_API void chip8_seed(chip8_instance* instance, uint32_t seed);
+
+// load a rom from a memory buffer at 0x200, returns false if it does not fit
+CHIP8_API bool chip8_load_rom(chip8_instance* instance, const uint8_t* data, size_t size);
+
+// read-only view of the 4k memory, valid until the instance is destroyed
+CHIP8_API const uint8_t* chip8_memory(const chip8_instance* instance);
+
+// hash of memory, display, registers, stack, and timers, maintained incrementally by the core
+CHIP8_API uint64_t chip8_state_hash(const chip8_instance* instance);
+
+// advance count instances by n_frames each in a single call
+//   inputs:       count * n_frames keypad bitmasks (bit k = key k held), may be null for no input
+//   framebuffers: count * CHIP8_FRAMEBUFFER_SIZE bytes receiving the final display (0/1 per pixel), may be null
+//   states:       count entries receiving the final machine state, may be null
+// outputs are written once per instance after its last frame, never per frame
+// memory, stack, and keypad indices wrap inside the core, so no rom can access memory outside its instance
+CHIP8_API void chip8_step(chip8_instance* const* instances, size_t count, size_t n_frames,
+	const uint16_t* inputs, uint8_t* framebuffers, chip8_state* states);
+
+// visited set shared between threads, holds 2^capacity_log2 hashes (1 to 59 on 64-bit, 1 to 27 on 32-bit),
+// returns null if capacity_log2 is out of range or the table could not be allocated
+CHIP8_API chip8_visited* chip8_visited_create(size_t capacity_log2);
+CHIP8_API void chip8_visited_destroy(chip8_visited* visited);
+
+// returns true if the hash was newly recorded, false if already seen or the set is full
+CHIP8_API bool chip8_visited_insert(chip8_visited* visited, uint64_t hash);
+CHIP8_API size_t chip8_visited_size(const chip8_visited* visited);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,478 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chip8.h"
+#include "opcode.h"
+
+// differential conformance harness: runs the reference interpreter (chip8::cycle) and an
+// alternative engine in lockstep on random programs and roms, and shrinks any divergence
+// to a minimal reproducing program
+
+namespace {
+
+using program = std::vector<uint8_t>;
+
+struct engine {
+	const char* name;
+	void (*step)(chip8& c8); // execute the instruction at pc
+};
+
+uint16_t fetch(const chip8& c8) {
+	return static_cast<uint16_t>(c8.memory_[c8.pc_ & 0xFFF] << 8 | c8.memory_[(c8.pc_ + 1) & 0xFFF]);
+}
+
+void switch_step(chip8& c8) {
+	opcode::execute_switch(c8, fetch(c8));
+}
+
+// alternative engines checked against the reference, new execution engines register here
+constexpr engine engines[] = {
+	{ "switch", switch_step },
+};
+
+struct options {
+	size_t programs = 100000;	 // random programs to check
+	size_t length = 64;			 // instructions per random program
+	size_t frames = 30;			 // frames to run each random program for
+	size_t rom_frames = 600;	 // frames to run each rom for, long enough to get past title screens
+	size_t compare_interval = 1; // instructions between state comparisons
+	uint64_t seed = 1;
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	const engine* alt = &engines[0];
+	std::vector<std::string> roms;
+	std::string rom_dir = "demos"; // checked when no roms are given
+};
+
+// bundled roms checked by default
+constexpr const char* demo_roms[] = {
+	"brix.ch8", "invaders.c8", "pong2.c8", "rushhour.ch8", "test_opcode.ch8", "tetris.c8",
+};
+
+struct divergence {
+	size_t instruction = 0; // instructions executed when the divergence was detected
+	const char* field = nullptr;
+};
+
+// result of running one program on both engines
+enum class outcome {
+	agree,
+	diverge,
+	load_failed, // the program could not be loaded, a hard error rather than a pass
+};
+
+// programs are loaded at 0x200, anything longer does not fit in memory
+constexpr size_t max_program_length = (4096 - 0x200) / 2;
+
+struct job {
+	std::string name;
+	program code;
+	uint64_t seed; // drives keypad input and Cxnn
+	size_t frames;
+};
+
+// returns the first machine state field that differs, or nullptr if the states match
+const char* compare_state(const chip8& a, const chip8& b) {
+	if (std::memcmp(a.memory_, b.memory_, sizeof(a.memory_)) != 0)
+		return "memory";
+	if (std::memcmp(a.gfx_, b.gfx_, sizeof(a.gfx_)) != 0)
+		return "gfx";
+	if (std::memcmp(a.v_, b.v_, sizeof(a.v_)) != 0)
+		return "v";
+	if (a.i_ != b.i_)
+		return "i";
+	if (a.pc_ != b.pc_)
+		return "pc";
+	if (a.sp_ != b.sp_)
+		return "sp";
+	if (std::memcmp(a.stack_, b.stack_, sizeof(a.stack_)) != 0)
+		return "stack";
+	if (a.delay_timer_ != b.delay_timer_)
+		return "delay_timer";
+	if (a.sound_timer_ != b.sound_timer_)
+		return "sound_timer";
+	if (a.should_draw_ != b.should_draw_)
+		return "should_draw";
+	if (a.state_hash() != b.state_hash())
+		return "state_hash";
+	return nullptr;
+}
+
+// a pair of machines reused across runs, constructing the opcode tables per run would dominate
+struct lockstep {
+	chip8 ref;
+	chip8 alt;
+
+	outcome run(const program& code, const uint64_t seed, const size_t frames, const options& opts, divergence& found) {
+		ref.reset();
+		alt.reset();
+		if (!ref.load_rom(code.data(), code.size()) || !alt.load_rom(code.data(), code.size()))
+			return outcome::load_failed;
+
+		// both engines must draw the same random bytes for Cxnn
+		ref.seed(static_cast<uint32_t>(seed));
+		alt.seed(static_cast<uint32_t>(seed));
+
+		std::mt19937_64 input(seed);
+		size_t executed = 0;
+
+		for (size_t frame = 0; frame < frames; ++frame) {
+			const uint16_t keys = static_cast<uint16_t>(input());
+			for (int k = 0; k < 16; ++k)
+				ref.key_[k] = alt.key_[k] = (keys >> k) & 1;
+
+			for (int c = 0; c < chip8::cycles_per_frame; ++c) {
+				ref.cycle();
+				opts.alt->step(alt);
+
+				++executed;
+				if (executed % opts.compare_interval == 0 && diverged(executed, found))
+					return outcome::diverge;
+			}
+
+			ref.update_timers();
+			alt.update_timers();
+		}
+
+		return finish(executed, found) ? outcome::diverge : outcome::agree;
+	}
+
+	// final comparison at the end of a run
+	bool finish(const size_t executed, divergence& found) const {
+		if (diverged(executed, found))
+			return true;
+
+		// the incremental hash must match a full rebuild, or a write bypassed write_memory/toggle_pixel
+		for (const chip8* c8 : { &ref, &alt }) {
+			if (c8->state_hash() != c8->recompute_state_hash()) {
+				found.instruction = executed;
+				found.field = c8 == &ref ? "reference state_hash (incremental != recomputed)"
+					: "alternative state_hash (incremental != recomputed)";
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool diverged(const size_t executed, divergence& found) const {
+		const char* field = compare_state(ref, alt);
+		if (!field)
+			return false;
+
+		found.instruction = executed;
+		found.field = field;
+		return true;
+	}
+};
+
+// a true no-op (V0 = V0), used to blank out instructions while shrinking
+constexpr uint16_t neutral_instruction = 0x8000;
+
+// erase count bytes at offset start, retargeting 1nnn/2nnn/Bnnn so jumps past the gap still land
+// on the same instruction and jumps into it land where it was
+program erase_instructions(const program& code, const size_t start, const size_t count) {
+	program result(code.begin(), code.begin() + static_cast<std::ptrdiff_t>(start));
+	result.insert(result.end(), code.begin() + static_cast<std::ptrdiff_t>(start + count), code.end());
+
+	const size_t removed_begin = 0x200 + start;
+	const size_t removed_end = removed_begin + count;
+
+	for (size_t i = 0; i + 1 < result.size(); i += 2) {
+		const uint16_t op = result[i] << 8 & 0xF000;
+		if (op != 0x1000 && op != 0x2000 && op != 0xB000)
+			continue;
+
+		size_t target = (result[i] << 8 | result[i + 1]) & 0x0FFF;
+		if (target >= removed_end)
+			target -= count;
+		else if (target > removed_begin)
+			target = removed_begin;
+
+		result[i] = static_cast<uint8_t>((op | target) >> 8);
+		result[i + 1] = static_cast<uint8_t>(target & 0xFF);
+	}
+
+	return result;
+}
+
+// only candidates failing on the same field as the original count, so shrinking cannot drift to another bug
+program shrink(program code, const job& j, const char* field, const options& opts, lockstep& machines) {
+	const auto diverges = [&](const program& candidate) {
+		divergence found;
+		return machines.run(candidate, j.seed, j.frames, opts, found) == outcome::diverge && std::strcmp(found.field, field) == 0;
+	};
+
+	// remove runs of instructions anywhere in the program, halving the run length until single
+	// instructions have been tried
+	const auto remove_instructions = [&] {
+		for (size_t chunk = code.size() / 4 * 2; chunk >= 2; chunk = chunk / 4 * 2) {
+			for (size_t end = code.size() & ~static_cast<size_t>(1); end >= chunk; end -= chunk) {
+				const program candidate = erase_instructions(code, end - chunk, chunk);
+				if (diverges(candidate))
+					code = candidate;
+			}
+		}
+	};
+
+	remove_instructions();
+
+	// blank out individual instructions that are not needed to reproduce
+	for (size_t i = 0; i + 1 < code.size(); i += 2) {
+		if ((code[i] << 8 | code[i + 1]) == neutral_instruction)
+			continue;
+
+		program candidate = code;
+		candidate[i] = neutral_instruction >> 8;
+		candidate[i + 1] = neutral_instruction & 0xFF;
+		if (diverges(candidate))
+			code = candidate;
+	}
+
+	// blanked instructions are often removable outright once their neighbours are gone
+	remove_instructions();
+	return code;
+}
+
+// random instruction stream biased towards valid opcodes, jumps and calls stay inside the program
+program generate_program(const uint64_t seed, const size_t length) {
+	struct pattern {
+		uint16_t base;
+		uint16_t operands; // bits filled at random
+	};
+
+	static constexpr pattern patterns[] = {
+		{ 0x00E0, 0x0000 }, { 0x00EE, 0x0000 }, { 0x1000, 0x0000 }, { 0x2000, 0x0000 },
+		{ 0x3000, 0x0FFF }, { 0x4000, 0x0FFF }, { 0x5000, 0x0FF0 }, { 0x6000, 0x0FFF },
+		{ 0x7000, 0x0FFF }, { 0x8000, 0x0FF0 }, { 0x8001, 0x0FF0 }, { 0x8002, 0x0FF0 },
+		{ 0x8003, 0x0FF0 }, { 0x8004, 0x0FF0 }, { 0x8005, 0x0FF0 }, { 0x8006, 0x0FF0 },
+		{ 0x8007, 0x0FF0 }, { 0x800E, 0x0FF0 }, { 0x9000, 0x0FF0 }, { 0xA000, 0x0FFF },
+		{ 0xB000, 0x0000 }, { 0xC000, 0x0FFF }, { 0xD000, 0x0FFF }, { 0xE09E, 0x0F00 },
+		{ 0xE0A1, 0x0F00 }, { 0xF007, 0x0F00 }, { 0xF00A, 0x0F00 }, { 0xF015, 0x0F00 },
+		{ 0xF018, 0x0F00 }, { 0xF01E, 0x0F00 }, { 0xF029, 0x0F00 }, { 0xF033, 0x0F00 },
+		{ 0xF055, 0x0F00 }, { 0xF065, 0x0F00 },
+	};
+
+	std::mt19937_64 rng(seed);
+	std::uniform_int_distribution<size_t> pick(0, sizeof(patterns) / sizeof(patterns[0]) - 1);
+	std::uniform_int_distribution<size_t> target(0, length - 1);
+
+	program code;
+	code.reserve(length * 2);
+
+	for (size_t n = 0; n < length; ++n) {
+		const pattern& p = patterns[pick(rng)];
+		uint16_t instruction = p.base | (static_cast<uint16_t>(rng()) & p.operands);
+
+		// 1nnn, 2nnn, and Bnnn address an instruction inside the program
+		if (p.base == 0x1000 || p.base == 0x2000 || p.base == 0xB000)
+			instruction = static_cast<uint16_t>(p.base | (0x200 + target(rng) * 2));
+
+		code.push_back(static_cast<uint8_t>(instruction >> 8));
+		code.push_back(static_cast<uint8_t>(instruction & 0xFF));
+	}
+
+	return code;
+}
+
+bool read_rom(const std::string& filename, program& code) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "failed to open file: " << filename << std::endl;
+		return false;
+	}
+
+	code.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	if (code.size() > (4096 - 512)) {
+		std::cerr << "rom file too large: " << filename << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void print_usage() {
+	std::cerr << "usage: conformance [--programs n] [--length n] [--frames n] [--rom-frames n] [--seed n]\n"
+		"                   [--threads n] [--granularity instruction|frame|<instructions>] [--engine name]\n"
+		"                   [--rom-dir dir] [rom...]\n"
+		"with no roms, every bundled rom in --rom-dir (default demos) is checked\n";
+}
+
+bool parse_args(const int argc, char* argv[], options& opts) {
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		const bool has_value = i + 1 < argc;
+
+		if (arg.rfind("--", 0) != 0) {
+			opts.roms.push_back(arg);
+			continue;
+		}
+
+		if (!has_value)
+			return false;
+
+		const std::string value = argv[++i];
+		try {
+			if (arg == "--programs")
+				opts.programs = std::stoull(value);
+			else if (arg == "--length") {
+				opts.length = std::max<size_t>(1, std::stoull(value));
+				if (opts.length > max_program_length) {
+					std::cerr << "--length must be at most " << max_program_length << std::endl;
+					return false;
+				}
+			}
+			else if (arg == "--frames")
+				opts.frames = std::stoull(value);
+			else if (arg == "--rom-frames")
+				opts.rom_frames = std::stoull(value);
+			else if (arg == "--rom-dir")
+				opts.rom_dir = value;
+			else if (arg == "--seed")
+				opts.seed = std::stoull(value);
+			else if (arg == "--threads")
+				opts.threads = std::max(1u, static_cast<unsigned>(std::stoul(value)));
+			else if (arg == "--granularity") {
+				if (value == "instruction")
+					opts.compare_interval = 1;
+				else if (value == "frame")
+					opts.compare_interval = chip8::cycles_per_frame;
+				else
+					opts.compare_interval = std::max<size_t>(1, std::stoull(value));
+			}
+			else if (arg == "--engine") {
+				const auto it = std::find_if(std::begin(engines), std::end(engines),
+					[&value](const engine& e) { return value == e.name; });
+				if (it == std::end(engines))
+					return false;
+				opts.alt = it;
+			}
+			else
+				return false;
+		}
+		catch (const std::invalid_argument&) {
+			std::cerr << "invalid value for " << arg << ": " << value << std::endl;
+			return false;
+		}
+		catch (const std::out_of_range&) {
+			std::cerr << "value out of range for " << arg << ": " << value << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace
+
+int main(const int argc, char* argv[]) {
+	options opts;
+	if (!parse_args(argc, argv, opts)) {
+		print_usage();
+		return 1;
+	}
+
+	if (opts.roms.empty()) {
+		for (const char* name : demo_roms)
+			opts.roms.push_back(opts.rom_dir + "/" + name);
+	}
+
+	// roms first, then the random programs, all handed out to workers by index
+	std::vector<job> rom_jobs;
+	for (const auto& filename : opts.roms) {
+		job j{ filename, {}, opts.seed, opts.rom_frames };
+		if (!read_rom(filename, j.code))
+			return 1;
+		rom_jobs.push_back(std::move(j));
+	}
+
+	const size_t total = rom_jobs.size() + opts.programs;
+	const auto make_job = [&](const size_t index) {
+		if (index < rom_jobs.size())
+			return rom_jobs[index];
+
+		const uint64_t seed = opts.seed + (index - rom_jobs.size());
+		return job{ "random program seed " + std::to_string(seed), generate_program(seed, opts.length), seed, opts.frames };
+	};
+
+	std::atomic<size_t> next(0);
+	std::atomic<size_t> first_failure(total);
+	std::mutex failure_mutex;
+	divergence failure;
+	outcome failure_outcome = outcome::agree;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	const auto worker = [&] {
+		const auto machines = std::make_unique<lockstep>();
+
+		for (size_t index = next++; index < first_failure.load(); index = next++) {
+			const job j = make_job(index);
+			divergence found;
+			const outcome result = machines->run(j.code, j.seed, j.frames, opts, found);
+			if (result == outcome::agree)
+				continue;
+
+			// keep the lowest failing index so repeated runs report the same program
+			std::lock_guard<std::mutex> lock(failure_mutex);
+			if (index < first_failure.load()) {
+				first_failure = index;
+				failure = found;
+				failure_outcome = result;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < opts.threads; ++t)
+		threads.emplace_back(worker);
+	for (auto& thread : threads)
+		thread.join();
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start);
+
+	if (first_failure.load() == total) {
+		std::cout << "reference and " << opts.alt->name << " agree on " << total << " programs ("
+			<< opts.threads << " threads, " << elapsed.count() << " ms)" << std::endl;
+		return 0;
+	}
+
+	const job j = make_job(first_failure.load());
+	if (failure_outcome == outcome::load_failed) {
+		std::cerr << "failed to load " << j.name << " (" << j.code.size() << " bytes)" << std::endl;
+		return 1;
+	}
+
+	std::cout << "reference vs " << opts.alt->name << " failed on " << j.name << ": "
+		<< failure.field << " differs after " << failure.instruction << " instructions" << std::endl;
+
+	lockstep machines;
+	const program minimal = shrink(j.code, j, failure.field, opts, machines);
+
+	divergence shrunk;
+	machines.run(minimal, j.seed, j.frames, opts, shrunk);
+	std::cout << "minimal program (" << minimal.size() / 2 << " instructions, " << shrunk.field
+		<< " differs after " << shrunk.instruction << " instructions):" << std::endl;
+
+	for (size_t i = 0; i + 1 < minimal.size(); i += 2) {
+		std::cout << "  " << std::hex << std::uppercase << std::setfill('0')
+			<< std::setw(3) << 0x200 + i << ": " << std::setw(4) << (minimal[i] << 8 | minimal[i + 1])
+			<< std::dec << std::nouppercase << std::endl;
+	}
+
+	return 1;
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#include "debug_overlay.h"
+
+namespace {
+
+// 3x5 pixel glyphs, one bit per pixel, rows top to bottom in the high bits first
+uint16_t glyph(const char c) {
+	switch (c) {
+	case '0': return 0b111'101'101'101'111;
+	case '1': return 0b010'110'010'010'111;
+	case '2': return 0b111'001'111'100'111;
+	case '3': return 0b111'001'111'001'111;
+	case '4': return 0b101'101'111'001'001;
+	case '5': return 0b111'100'111'001'111;
+	case '6': return 0b111'100'111'101'111;
+	case '7': return 0b111'001'010'100'100;
+	case '8': return 0b111'101'111'101'111;
+	case '9': return 0b111'101'111'001'111;
+	case 'A': return 0b111'101'111'101'101;
+	case 'B': return 0b110'101'110'101'110;
+	case 'C': return 0b111'100'100'100'111;
+	case 'D': return 0b110'101'101'101'110;
+	case 'E': return 0b111'100'111'100'111;
+	case 'F': return 0b111'100'111'100'100;
+	case 'I': return 0b111'010'010'010'111;
+	case 'K': return 0b101'101'110'101'101;
+	case 'M': return 0b101'111'111'101'101;
+	case 'P': return 0b111'101'111'100'100;
+	case 'R': return 0b110'101'110'101'101;
+	case 'S': return 0b111'100'111'001'111;
+	case 'T': return 0b111'010'010'010'010;
+	case 'V': return 0b101'101'101'101'010;
+	case '.': return 0b000'000'000'000'010;
+	case '>': return 0b100'010'001'010'100;
+	default: return 0;
+	}
+}
+
+} // namespace
+
+debug_overlay::debug_overlay()
+	: snapshot_(), heat_(),
+	  frames_since_decay_(0), instructions_(0), instructions_per_second_(0),
+	  window_start_(std::chrono::steady_clock::now()), heatmap_texture_(nullptr) {
+	glyph_rects_.reserve(4096);
+}
+
+debug_overlay::~debug_overlay() {
+	SDL_DestroyTexture(heatmap_texture_);
+}
+
+void debug_overlay::init(SDL_Renderer* renderer) {
+	heatmap_texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+		SDL_TEXTUREACCESS_STREAMING, heatmap_columns, heatmap_rows);
+}
+
+void debug_overlay::step_frame(chip8& c8, const std::chrono::microseconds frame_time) {
+	// record every executed pc, nothing is added to chip8::cycle() itself
+	for (int c = 0; c < chip8::cycles_per_frame; ++c) {
+		uint16_t& hits = heat_[c8.pc_ & 0xFFF];
+		if (hits < UINT16_MAX)
+			++hits;
+		c8.cycle();
+	}
+	c8.update_timers();
+
+	if (++frames_since_decay_ == heat_decay_frames) {
+		for (auto& h : heat_)
+			h >>= 1;
+		frames_since_decay_ = 0;
+	}
+
+	// instructions per second over a one second window
+	instructions_ += chip8::cycles_per_frame;
+	const auto now = std::chrono::steady_clock::now();
+	const auto window = std::chrono::duration_cast<std::chrono::microseconds>(now - window_start_);
+	if (window >= std::chrono::seconds(1)) {
+		instructions_per_second_ = static_cast<uint32_t>(instructions_ * 1000000 / window.count());
+		instructions_ = 0;
+		window_start_ = now;
+	}
+
+	// copy what draw() needs into the snapshot
+	std::copy(std::begin(c8.v_), std::end(c8.v_), std::begin(snapshot_.v));
+	std::copy(std::begin(c8.stack_), std::end(c8.stack_), std::begin(snapshot_.stack));
+	snapshot_.i = c8.i_;
+	snapshot_.pc = c8.pc_;
+	snapshot_.sp = c8.sp_;
+	snapshot_.delay_timer = c8.delay_timer_;
+	snapshot_.sound_timer = c8.sound_timer_;
+	snapshot_.instructions_per_second = instructions_per_second_;
+	snapshot_.frame_ms = static_cast<float>(frame_time.count()) / 1000.0f;
+	snapshot_.heat = heat_;
+	snapshot_.heat_max = *std::max_element(heat_.begin(), heat_.end());
+}
+
+void debug_overlay::draw(SDL_Renderer* renderer) {
+	draw_heatmap(renderer, snapshot_);
+	draw_panel(renderer, snapshot_);
+}
+
+void debug_overlay::draw_heatmap(SDL_Renderer* renderer, const debug_snapshot& snapshot) {
+	std::array<uint32_t, 4096> buffer;
+	const uint32_t max = std::max<uint32_t>(snapshot.heat_max, 1);
+
+	// dark blue for cold addresses up to bright yellow for the hottest one
+	for (size_t address = 0; address < buffer.size(); ++address) {
+		const uint32_t level = snapshot.heat[address] * 255 / max;
+		buffer[address] = 0xFF000000 | level << 16 | level << 8 | (level ? 0 : 0x20);
+	}
+
+	// the current pc and i are always marked
+	buffer[snapshot.pc & 0xFFF] = 0xFFFF0000;
+	buffer[snapshot.i & 0xFFF] = 0xFF00FF00;
+
+	SDL_UpdateTexture(heatmap_texture_, nullptr, buffer.data(), heatmap_columns * sizeof(uint32_t));
+
+	const SDL_Rect dst = { 0, chip8::screen_height * frontend::window_scale,
+		chip8::screen_width * frontend::window_scale, heatmap_height };
+	SDL_RenderCopy(renderer, heatmap_texture_, nullptr, &dst);
+}
+
+void debug_overlay::draw_panel(SDL_Renderer* renderer, const debug_snapshot& snapshot) {
+	const int left = chip8::screen_width * frontend::window_scale + 2 * font_scale * 4;
+	int y = 2 * font_scale * 4;
+	char line[32];
+
+	glyph_rects_.clear();
+
+	std::snprintf(line, sizeof(line), "PC %04X  I %04X", snapshot.pc, snapshot.i);
+	draw_text(left, y, line);
+	y += line_height;
+
+	std::snprintf(line, sizeof(line), "DT %02X  ST %02X", snapshot.delay_timer, snapshot.sound_timer);
+	draw_text(left, y, line);
+	y += line_height * 2;
+
+	// registers, two per line
+	for (int r = 0; r < 16; r += 2) {
+		std::snprintf(line, sizeof(line), "V%X %02X  V%X %02X", r, snapshot.v[r], r + 1, snapshot.v[r + 1]);
+		draw_text(left, y, line);
+		y += line_height;
+	}
+	y += line_height;
+
+	std::snprintf(line, sizeof(line), "STACK  SP %02X", snapshot.sp);
+	draw_text(left, y, line);
+	y += line_height;
+
+	// stack entries, the top of the stack is marked
+	for (int s = 0; s < 16; s += 2) {
+		std::snprintf(line, sizeof(line), "%c%X %03X %c%X %03X",
+			s + 1 == snapshot.sp ? '>' : ' ', s, snapshot.stack[s],
+			s + 2 == snapshot.sp ? '>' : ' ', s + 1, snapshot.stack[s + 1]);
+		draw_text(left, y, line);
+		y += line_height;
+	}
+	y += line_height;
+
+	std::snprintf(line, sizeof(line), "IPS %u", snapshot.instructions_per_second);
+	draw_text(left, y, line);
+	y += line_height;
+
+	std::snprintf(line, sizeof(line), "FRAME %.2f MS", snapshot.frame_ms);
+	draw_text(left, y, line);
+
+	SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+	SDL_RenderFillRects(renderer, glyph_rects_.data(), static_cast<int>(glyph_rects_.size()));
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+}
+
+void debug_overlay::draw_text(int x, const int y, const char* text) {
+	for (; *text; ++text, x += 4 * font_scale) {
+		const uint16_t bits = glyph(*text);
+
+		for (int row = 0; row < 5; ++row)
+			for (int col = 0; col < 3; ++col)
+				if (bits & (1 << (14 - row * 3 - col)))
+					glyph_rects_.push_back({ x + col * font_scale, y + row * font_scale, font_scale, font_scale });
+	}
+}
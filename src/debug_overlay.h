@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL2/SDL_render.h>
+#include <array>
+#include <chrono>
+#include <vector>
+
+#include "chip8.h"
+#include "frontend.h"
+
+// machine state as seen by the overlay, captured once per frame by step_frame()
+struct debug_snapshot {
+	uint8_t v[16];
+	uint16_t i;
+	uint16_t pc;
+	uint16_t sp;
+	uint16_t stack[16];
+	uint8_t delay_timer;
+	uint8_t sound_timer;
+
+	uint32_t instructions_per_second; // emulated instructions over the last second
+	float frame_ms;					  // time spent emulating and drawing the last frame
+
+	std::array<uint16_t, 4096> heat; // decayed execution counts per memory address
+	uint16_t heat_max;
+};
+
+class debug_overlay {
+public:
+	static constexpr int panel_width = 200;	   // register panel to the right of the screen
+	static constexpr int heatmap_height = 160; // pc heatmap below the screen
+	static constexpr int heatmap_columns = 128;
+	static constexpr int heatmap_rows = 4096 / heatmap_columns;
+
+	static constexpr int window_width = chip8::screen_width * frontend::window_scale + panel_width;
+	static constexpr int window_height = chip8::screen_height * frontend::window_scale + heatmap_height;
+
+	debug_overlay();
+	~debug_overlay();
+
+	void init(SDL_Renderer* renderer);
+
+	// run one frame, recording the pc of every executed instruction, then take a snapshot
+	void step_frame(chip8& c8, std::chrono::microseconds frame_time);
+
+	// draw the snapshot from the last step_frame(), the caller clears and presents
+	void draw(SDL_Renderer* renderer);
+
+	static SDL_Rect screen_rect() {
+		return { 0, 0, chip8::screen_width * frontend::window_scale, chip8::screen_height * frontend::window_scale };
+	}
+private:
+	static constexpr int heat_decay_frames = 60; // halve the heatmap once a second
+	static constexpr int font_scale = 2;
+	static constexpr int line_height = 6 * font_scale;
+
+	void draw_heatmap(SDL_Renderer* renderer, const debug_snapshot& snapshot);
+	void draw_panel(SDL_Renderer* renderer, const debug_snapshot& snapshot);
+	void draw_text(int x, int y, const char* text);
+
+	// emulation and drawing both run on the main thread, so the snapshot is a plain copy
+	debug_snapshot snapshot_;
+
+	std::array<uint16_t, 4096> heat_;
+	int frames_since_decay_;
+	uint64_t instructions_;
+	uint32_t instructions_per_second_;
+	std::chrono::steady_clock::time_point window_start_;
+
+	SDL_Texture* heatmap_texture_;
+	std::vector<SDL_Rect> glyph_rects_; // text pixels batched into a single fill call
+};
@@ -0,0 +1,85 @@
+#include <SDL2/SDL_events.h>
+
+#include <array>
+
+#include "frontend.h"
+
+frontend::frontend() = default;
+frontend::~frontend() {
+	SDL_DestroyTexture(texture_);
+}
+
+void frontend::init(SDL_Renderer* renderer) {
+	texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+		SDL_TEXTUREACCESS_STREAMING, chip8::screen_width, chip8::screen_height);
+
+	// streaming textures start with undefined contents, show a black screen until the first draw
+	std::array<uint32_t, static_cast<size_t>(chip8::screen_width) * chip8::screen_height> buffer;
+	buffer.fill(0xFF000000);
+	SDL_UpdateTexture(texture_, nullptr, buffer.data(), chip8::screen_width * sizeof(uint32_t));
+}
+
+void frontend::draw(chip8& c8, SDL_Renderer* renderer) {
+	if (update_texture(c8)) {
+		// clear the renderer and render the texture
+		SDL_RenderClear(renderer);
+		render(renderer, nullptr);
+		SDL_RenderPresent(renderer);
+	}
+}
+
+bool frontend::update_texture(chip8& c8) {
+	if (!c8.should_draw_)
+		return false;
+
+	std::array<uint32_t, static_cast<size_t>(chip8::screen_width) * chip8::screen_height> buffer;
+
+	// copy the gfx buffer to the back buffer
+	for (int i = 0; i < chip8::screen_width * chip8::screen_height; ++i)
+		buffer[i] = c8.gfx_[i] ? 0xFFFFFFFF : 0xFF000000;
+
+	// update the texture with new pixel data
+	SDL_UpdateTexture(texture_, nullptr, buffer.data(), chip8::screen_width * sizeof(uint32_t));
+
+	// reset the draw flag
+	c8.should_draw_ = false;
+	return true;
+}
+
+void frontend::render(SDL_Renderer* renderer, const SDL_Rect* dst) const {
+	SDL_RenderCopy(renderer, texture_, nullptr, dst);
+}
+
+void frontend::input(chip8& c8) {
+	SDL_Event e;
+
+	// map the chip-8 keypad to keyboard keys
+	static constexpr std::array<SDL_Keycode, 16> keymap = {
+		SDLK_x, SDLK_1, SDLK_2, SDLK_3,
+		SDLK_q, SDLK_w, SDLK_e, SDLK_a,
+		SDLK_s, SDLK_d, SDLK_z, SDLK_c,
+		SDLK_4, SDLK_r, SDLK_f, SDLK_v
+	};
+
+	while (SDL_PollEvent(&e)) {
+		if (e.type == SDL_QUIT)
+			quit_ = true;
+
+		if (e.type == SDL_KEYDOWN) {
+			if (e.key.keysym.sym == SDLK_ESCAPE)
+				quit_ = true;
+
+			// set key state to pressed 
+			for (int i = 0; i < 16; ++i)
+				if (e.key.keysym.sym == keymap[i])
+					c8.key_[i] = 1;
+		}
+
+		if (e.type == SDL_KEYUP) {
+			// set key state to released
+			for (int i = 0; i < 16; ++i)
+				if (e.key.keysym.sym == keymap[i])
+					c8.key_[i] = 0;
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <SDL2/SDL_render.h>
+
+#include "chip8.h"
+
+// sdl side of the emulator: owns the screen texture and maps keyboard events onto the keypad
+class frontend {
+public:
+	static constexpr int window_scale = 10;
+
+	frontend();
+	~frontend();
+
+	void init(SDL_Renderer* renderer);
+	void draw(chip8& c8, SDL_Renderer* renderer);  // draw the graphics buffer to the screen
+	bool update_texture(chip8& c8);				   // upload the graphics buffer if it changed, returns true if it did
+	void render(SDL_Renderer* renderer, const SDL_Rect* dst) const; // copy the texture into dst (nullptr for the whole target)
+	void input(chip8& c8);						   // handle input events
+
+	bool should_quit() const { return quit_; }
+private:
+	SDL_Texture* texture_ = nullptr;
+
+	bool quit_ = false; // flag to indicate if the program should quit
+};
@@ -1,22 +1,72 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
 
+#include <cstring>
 #include <iostream>
 #include <thread>
 
 #include "chip8.h"
+#include "debug_overlay.h"
+#include "frontend.h"
+
+// the frontend and overlay textures belong to the renderer, so they live in here and are
+// released when this returns, before the caller destroys the renderer
+static void run(chip8& c8, SDL_Renderer* renderer, const bool debug) {
+	frontend fe;
+	fe.init(renderer);
+
+	debug_overlay overlay;
+	if (debug)
+		overlay.init(renderer);
+
+	std::chrono::microseconds last_frame_duration(0);
+
+	while (!fe.should_quit()) {
+		auto frame_start = std::chrono::high_resolution_clock::now();
+
+		fe.input(c8);
+
+		if (debug) {
+			// emulate one frame through the overlay so it can record every executed pc
+			overlay.step_frame(c8, last_frame_duration);
+
+			// the overlay changes every frame, so redraw everything rather than only on display changes
+			fe.update_texture(c8);
+
+			const SDL_Rect screen = debug_overlay::screen_rect();
+			SDL_RenderClear(renderer);
+			fe.render(renderer, &screen);
+			overlay.draw(renderer);
+			SDL_RenderPresent(renderer);
+		} else {
+			c8.step_frame(); // emulate one frame of cycles and update timers at 60hz
+			fe.draw(c8, renderer);
+		}
+
+		// calculate time spent processing this frame
+		auto frame_end = std::chrono::high_resolution_clock::now();
+		auto frame_duration = std::chrono::duration_cast<std::chrono::microseconds>(frame_end - frame_start);
+		last_frame_duration = frame_duration;
+
+		// sleep for the remaining time to maintain 60fps
+		std::this_thread::sleep_for(std::chrono::microseconds(16667) - frame_duration);
+	}
+}
 
 int main(const int argc, char* argv[]) {
-	if (argc != 2)
+	// usage: chip8 <rom> [--debug]
+	if (argc != 2 && !(argc == 3 && std::strcmp(argv[2], "--debug") == 0))
 		return 1;
 
+	const bool debug = argc == 3;
+
 	if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
 		return 1;
 
 	SDL_Window* window = SDL_CreateWindow("chip-8 emulator",
 		SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-		chip8::screen_width * chip8::window_scale,
-		chip8::screen_height * chip8::window_scale,
+		debug ? debug_overlay::window_width : chip8::screen_width * frontend::window_scale,
+		debug ? debug_overlay::window_height : chip8::screen_height * frontend::window_scale,
 		SDL_WINDOW_SHOWN);
 	if (!window) {
 		SDL_Quit();
@@ -31,7 +81,7 @@ int main(const int argc, char* argv[]) {
 	}
 
 	chip8 c8;
-	c8.init(renderer);
+	c8.reset();
 
 	if (!c8.load_rom(argv[1])) {
 		SDL_DestroyRenderer(renderer);
@@ -40,25 +90,7 @@ int main(const int argc, char* argv[]) {
 		return 1;
 	}
 
-	while (!c8.should_quit()) {
-		auto frame_start = std::chrono::high_resolution_clock::now();
-
-		c8.input();
-
-		for (int i = 0; i < 10; ++i)
-			c8.cycle(); // emulate 10 cycles per frame
-
-		c8.update_timers(); // update timers at 60hz
-
-		c8.draw(renderer);
-
-		// calculate time spent processing this frame
-		auto frame_end = std::chrono::high_resolution_clock::now();
-		auto frame_duration = std::chrono::duration_cast<std::chrono::microseconds>(frame_end - frame_start);
-
-		// sleep for the remaining time to maintain 60fps
-		std::this_thread::sleep_for(std::chrono::microseconds(16667) - frame_duration);
-	}
+	run(c8, renderer, debug);
 
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
@@ -3,9 +3,6 @@
 #include "opcode.h"
 #include "chip8.h"
 
-// thread_local ensures that each thread has its own instance of the random number generator
-thread_local std::mt19937 generator(std::random_device{}());
-
 opcode::opcode() {
     init();
 }
@@ -32,6 +29,68 @@ void opcode::execute(chip8& c8, const uint16_t opcode) const {
         it->second(c8, decoded);
 }
 
+void opcode::execute_switch(chip8& c8, const uint16_t opcode) {
+    const decoded_opcode decoded = decode_opcode(opcode);
+
+    switch (decoded.op) {
+    case 0x0:
+        switch (decoded.nn) {
+        case 0xE0: op_00E0(c8, decoded); break;
+        case 0xEE: op_00EE(c8, decoded); break;
+        default: break;
+        }
+        break;
+    case 0x1: op_1nnn(c8, decoded); break;
+    case 0x2: op_2nnn(c8, decoded); break;
+    case 0x3: op_3xnn(c8, decoded); break;
+    case 0x4: op_4xnn(c8, decoded); break;
+    case 0x5: op_5xy0(c8, decoded); break;
+    case 0x6: op_6xnn(c8, decoded); break;
+    case 0x7: op_7xnn(c8, decoded); break;
+    case 0x8:
+        switch (decoded.n) {
+        case 0x0: op_8xy0(c8, decoded); break;
+        case 0x1: op_8xy1(c8, decoded); break;
+        case 0x2: op_8xy2(c8, decoded); break;
+        case 0x3: op_8xy3(c8, decoded); break;
+        case 0x4: op_8xy4(c8, decoded); break;
+        case 0x5: op_8xy5(c8, decoded); break;
+        case 0x6: op_8xy6(c8, decoded); break;
+        case 0x7: op_8xy7(c8, decoded); break;
+        case 0xE: op_8xyE(c8, decoded); break;
+        default: break;
+        }
+        break;
+    case 0x9: op_9xy0(c8, decoded); break;
+    case 0xA: op_Annn(c8, decoded); break;
+    case 0xB: op_Bnnn(c8, decoded); break;
+    case 0xC: op_Cxnn(c8, decoded); break;
+    case 0xD: op_Dxyn(c8, decoded); break;
+    case 0xE:
+        switch (decoded.nn) {
+        case 0x9E: op_Ex9E(c8, decoded); break;
+        case 0xA1: op_ExA1(c8, decoded); break;
+        default: break;
+        }
+        break;
+    case 0xF:
+        switch (decoded.nn) {
+        case 0x07: op_Fx07(c8, decoded); break;
+        case 0x0A: op_Fx0A(c8, decoded); break;
+        case 0x15: op_Fx15(c8, decoded); break;
+        case 0x18: op_Fx18(c8, decoded); break;
+        case 0x1E: op_Fx1E(c8, decoded); break;
+        case 0x29: op_Fx29(c8, decoded); break;
+        case 0x33: op_Fx33(c8, decoded); break;
+        case 0x55: op_Fx55(c8, decoded); break;
+        case 0x65: op_Fx65(c8, decoded); break;
+        default: break;
+        }
+        break;
+    default: break;
+    }
+}
+
 void opcode::init() {
     // initialize main table
     main_table_ = {
@@ -120,7 +179,7 @@ void opcode::exec_next_instruction(chip8& c8) {
 
 // clear display
 void opcode::op_00E0(chip8& c8, decoded_opcode decoded) {
-    std::fill(std::begin(c8.gfx_), std::end(c8.gfx_), 0);
+    c8.clear_display();
     c8.should_draw_ = true;
     exec_next_instruction(c8);
 }
@@ -128,7 +187,7 @@ void opcode::op_00E0(chip8& c8, decoded_opcode decoded) {
 // return from subroutine
 void opcode::op_00EE(chip8& c8, decoded_opcode decoded) {
     c8.sp_--;
-    c8.pc_ = c8.stack_[c8.sp_];
+    c8.pc_ = c8.stack_[c8.sp_ & 0xF]; // stack indices wrap at 16
     exec_next_instruction(c8);
 }
 
@@ -139,7 +198,7 @@ void opcode::op_1nnn(chip8& c8, decoded_opcode decoded) {
 
 // call subroutine at nnn
 void opcode::op_2nnn(chip8& c8, decoded_opcode decoded) {
-    c8.stack_[c8.sp_] = c8.pc_;
+    c8.stack_[c8.sp_ & 0xF] = c8.pc_; // stack indices wrap at 16
     c8.sp_++;
     c8.pc_ = decoded.nnn;
 }
@@ -262,7 +321,7 @@ void opcode::op_Bnnn(chip8& c8, const decoded_opcode decoded) {
 // set Vx = random byte AND nn
 void opcode::op_Cxnn(chip8& c8, const decoded_opcode decoded) {
     std::uniform_int_distribution<unsigned int> distribution(0, 0xFF);
-    c8.v_[decoded.x] = static_cast<uint8_t>(distribution(generator)) & decoded.nn;
+    c8.v_[decoded.x] = static_cast<uint8_t>(distribution(c8.generator_)) & decoded.nn;
     exec_next_instruction(c8);
 }
 
@@ -276,7 +335,7 @@ void opcode::op_Dxyn(chip8& c8, const decoded_opcode decoded) {
 
     // iterate over each row of the sprite
     for (uint8_t row = 0; row < height; row++) {
-		const uint8_t sprite_byte = c8.memory_[c8.i_ + row];
+		const uint8_t sprite_byte = c8.memory_[(c8.i_ + row) & 0xFFF];
 
         // iterate over each column of the sprite
 		for (uint8_t col = 0; col < 8; col++) {
@@ -291,7 +350,7 @@ void opcode::op_Dxyn(chip8& c8, const decoded_opcode decoded) {
 					c8.v_[0xF] = 1; // set collision flag
 
                 // draw the pixel
-                c8.gfx_[index] ^= 1;
+                c8.toggle_pixel(index);
 			}
 		}
 	}
@@ -302,7 +361,7 @@ void opcode::op_Dxyn(chip8& c8, const decoded_opcode decoded) {
 
 // skip next instruction if key with the value of Vx is pressed
 void opcode::op_Ex9E(chip8& c8, const decoded_opcode decoded) {
-    if (c8.key_[c8.v_[decoded.x]] != 0)
+    if (c8.key_[c8.v_[decoded.x] & 0xF] != 0)
         skip_next_instruction(c8);
     else
         exec_next_instruction(c8);
@@ -310,7 +369,7 @@ void opcode::op_Ex9E(chip8& c8, const decoded_opcode decoded) {
 
 // skip next instruction if key with the value of Vx is not pressed
 void opcode::op_ExA1(chip8& c8, const decoded_opcode decoded) {
-    if (c8.key_[c8.v_[decoded.x]] == 0)
+    if (c8.key_[c8.v_[decoded.x] & 0xF] == 0)
         skip_next_instruction(c8);
     else
         exec_next_instruction(c8);
@@ -361,9 +420,9 @@ void opcode::op_Fx29(chip8& c8, const decoded_opcode decoded) {
 // store BCD representation of Vx in memory locations I, I+1, and I+2
 void opcode::op_Fx33(chip8& c8, const decoded_opcode decoded) {
 	const uint8_t value = c8.v_[decoded.x];
-    c8.memory_[c8.i_] = value / 100;
-    c8.memory_[c8.i_ + 1] = (value / 10) % 10;
-    c8.memory_[c8.i_ + 2] = value % 10;
+    c8.write_memory(c8.i_, value / 100);
+    c8.write_memory(c8.i_ + 1, (value / 10) % 10);
+    c8.write_memory(c8.i_ + 2, value % 10);
     exec_next_instruction(c8);
 }
 
@@ -371,7 +430,7 @@ void opcode::op_Fx33(chip8& c8, const decoded_opcode decoded) {
 void opcode::op_Fx55(chip8& c8, const decoded_opcode decoded) {
 	const uint8_t x = decoded.x;
     for (int i = 0; i <= x; i++)
-        c8.memory_[c8.i_ + i] = c8.v_[i];
+        c8.write_memory(c8.i_ + i, c8.v_[i]);
 
     exec_next_instruction(c8);
 }
@@ -380,7 +439,7 @@ void opcode::op_Fx55(chip8& c8, const decoded_opcode decoded) {
 void opcode::op_Fx65(chip8& c8, const decoded_opcode decoded) {
 	const uint8_t x = decoded.x;
     for (int i = 0; i <= x; i++)
-        c8.v_[i] = c8.memory_[c8.i_ + i];
+        c8.v_[i] = c8.memory_[(c8.i_ + i) & 0xFFF];
 
     exec_next_instruction(c8);
 }
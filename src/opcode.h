@@ -24,6 +24,7 @@ public:
 	opcode();
 
 	void execute(chip8& c8, uint16_t opcode) const;
+	static void execute_switch(chip8& c8, uint16_t opcode); // switch dispatch to the same handlers, no table lookups
 private:
 	std::unordered_map<uint8_t, opcode_func> main_table_;
 	std::unordered_map<uint8_t, opcode_func> table0_;
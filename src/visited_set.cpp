@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <new>
+
+#include "visited_set.h"
+
+static_assert(sizeof(std::atomic<uint64_t>) <= 8, "max_capacity_log2 assumes 8 byte slots");
+
+visited_set::visited_set(const size_t capacity_log2)
+	: mask_((static_cast<size_t>(1) << std::min(std::max<size_t>(capacity_log2, 1), max_capacity_log2)) - 1),
+	  size_(0),
+	  zero_seen_(false) {
+	slots_.reset(new (std::nothrow) std::atomic<uint64_t>[mask_ + 1]);
+	if (slots_)
+		clear();
+}
+
+bool visited_set::insert(const uint64_t hash) {
+	if (hash == empty_) {
+		if (zero_seen_.exchange(true, std::memory_order_acq_rel))
+			return false;
+
+		size_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// linear probing, a slot is claimed with a single compare-exchange
+	for (size_t probe = 0, slot = hash & mask_; probe <= mask_; ++probe, slot = (slot + 1) & mask_) {
+		uint64_t current = slots_[slot].load(std::memory_order_acquire);
+
+		if (current == empty_) {
+			if (slots_[slot].compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+				size_.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			// another thread claimed this slot first, current now holds its key
+		}
+
+		if (current == hash)
+			return false;
+	}
+
+	return false; // table is full
+}
+
+bool visited_set::contains(const uint64_t hash) const {
+	if (hash == empty_)
+		return zero_seen_.load(std::memory_order_acquire);
+
+	for (size_t probe = 0, slot = hash & mask_; probe <= mask_; ++probe, slot = (slot + 1) & mask_) {
+		const uint64_t current = slots_[slot].load(std::memory_order_acquire);
+
+		if (current == hash)
+			return true;
+		if (current == empty_)
+			return false;
+	}
+
+	return false;
+}
+
+void visited_set::clear() {
+	for (size_t i = 0; i <= mask_; ++i)
+		slots_[i].store(empty_, std::memory_order_relaxed);
+
+	size_.store(0, std::memory_order_relaxed);
+	zero_seen_.store(false, std::memory_order_relaxed);
+}
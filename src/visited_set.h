@@ -0,0 +1,33 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// fixed capacity, lock-free set of state hashes shared between parallel explorers
+class visited_set {
+public:
+	// largest table whose size in bytes (8 per slot) stays below PTRDIFF_MAX, 59 on 64-bit and 27 on 32-bit
+	static constexpr size_t max_capacity_log2 = sizeof(size_t) * 8 - 5;
+
+	// capacity_log2 is clamped to [1, max_capacity_log2], check valid() in case the table could not be allocated
+	explicit visited_set(size_t capacity_log2 = 20);
+
+	bool valid() const { return slots_ != nullptr; }
+
+	// returns true if the hash was not seen before and has now been recorded,
+	// false if it was already present or the set is full
+	bool insert(uint64_t hash);
+	bool contains(uint64_t hash) const;
+
+	size_t size() const { return size_.load(std::memory_order_relaxed); }
+	size_t capacity() const { return mask_ + 1; }
+
+	void clear(); // not safe to call concurrently with insert/contains
+private:
+	static constexpr uint64_t empty_ = 0; // slot marker, hash 0 is tracked by zero_seen_ instead of a slot
+
+	std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+	size_t mask_;
+	std::atomic<size_t> size_;
+	std::atomic<bool> zero_seen_;
+};